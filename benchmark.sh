@@ -0,0 +1,14 @@
+#!/bin/bash
+# Scheduler benchmark: the dumbbell at 3, 100 and 1000 flows under every
+# scheduler, each (scheduler, flows) pair in its own process so that the
+# memory columns of one run are not inflated or hidden by earlier runs.
+# BENCHMARK_TIME sets the simulated seconds of each run.
+
+OUT=app7_scheduler_benchmark.txt
+printf "# one process per run, peak rss is the VmHWM of that process\n" > $OUT
+printf "#scheduler\tflows\tevents\twall(s)\tevents/s\trss growth(kB)\tpeak rss(kB)\n" >> $OUT
+for scheduler in Map Heap List Calendar PriorityQueue; do
+	for flows in 3 100 1000; do
+		./waf --run "scratch/app7 --benchmark=1 --scheduler=$scheduler --benchmarkFlows=$flows --benchmarkTime=${BENCHMARK_TIME:-5}" || exit 1
+	done
+done
@@ -0,0 +1,123 @@
+#!/bin/bash
+# Renders the app7 traces into PNGs.
+# Every series is streamed once through awk and reduced to the first, min,
+# max and last point of each pixel column (M4), which keeps the peaks while
+# bounding a plot to 4 points per column however long the run was.
+# M4 is only faithful when the points are joined, so every series is drawn
+# with lines: the column's min-max segment replaces the old band of points.
+# Downsampling and rendering both run REPORT_JOBS at a time.
+
+WIDTH=${REPORT_WIDTH:-640}
+HEIGHT=${REPORT_HEIGHT:-480}
+JOBS=${REPORT_JOBS:-$(nproc)}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+throttle() {
+	while [ "$(jobs -rp | wc -l)" -ge "$JOBS" ]; do
+		wait -n
+	done
+}
+
+# downsample <trace> <output>
+downsample() {
+	local first last
+	first=$(head -n 1 "$1" | cut -f 1)
+	last=$(tail -n 1 "$1" | cut -f 1)
+	awk -v xmin="$first" -v xmax="$last" -v cols="$WIDTH" '
+	function flush(    i, j, t, n) {
+		n = 0
+		px[++n] = fx; py[n] = fy
+		px[++n] = minx; py[n] = miny
+		px[++n] = maxx; py[n] = maxy
+		px[++n] = lx; py[n] = ly
+		for(i = 2; i <= n; i++)
+			for(j = i; j > 1 && px[j] < px[j-1]; j--) {
+				t = px[j]; px[j] = px[j-1]; px[j-1] = t
+				t = py[j]; py[j] = py[j-1]; py[j-1] = t
+			}
+		for(i = 1; i <= n; i++)
+			if(i == 1 || px[i] != px[i-1] || py[i] != py[i-1])
+				print px[i] "\t" py[i]
+	}
+	NF >= 2 && $1 + 0 == $1 {
+		c = xmax > xmin ? int(($1 - xmin) / (xmax - xmin) * (cols - 1)) : 0
+		if(seen && c != col) {
+			flush()
+			seen = 0
+		}
+		if(!seen) {
+			seen = 1; col = c
+			fx = minx = maxx = $1; fy = miny = maxy = $2
+		}
+		if($2 < miny) { minx = $1; miny = $2 }
+		if($2 > maxy) { maxx = $1; maxy = $2 }
+		lx = $1; ly = $2
+	}
+	END { if(seen) flush() }' "$1" > "$2"
+}
+
+# plot <png> <ylabel> <file> <title> [<file> <title>]...
+plot() {
+	local png=$1 ylabel=$2 series=""
+	shift 2
+	while [ $# -gt 0 ]; do
+		series="$series${series:+, }\"$TMP/$1\" using 1:2 with lines title \"$2\""
+		shift 2
+	done
+	gnuplot <<- EOF
+	set xlabel "time(in s)"
+	set ylabel "$ylabel"
+	set terminal png size $WIDTH,$HEIGHT
+	set output "$png"
+	plot $series
+	EOF
+}
+
+PARTS=("a|uniflow" "b|multiflow")
+FLOWS=("h1_h4|tcpreno|TcpReno" "h2_h5|tcpNewReno|TcpNewReno" "h3_h6|tcpBic|TcpBic")
+METRICS=("cwnd|cwnd|Congestion Window|cwnd(B)" "tp|throughput|Throughput|Throughput(Kbps)" "gp|goodput|Goodput|Goodput(Kbps)")
+
+for f in app7_*.cwnd app7_*.tp app7_*.gp; do
+	[ -s "$f" ] || continue
+	throttle
+	downsample "$f" "$TMP/$f" &
+done
+wait
+
+for p in "${PARTS[@]}"; do
+	IFS='|' read -r part partName <<< "$p"
+	for m in "${METRICS[@]}"; do
+		IFS='|' read -r ext label title ylabel <<< "$m"
+		overlay=()
+		for f in "${FLOWS[@]}"; do
+			IFS='|' read -r hosts file variant <<< "$f"
+			trace="app7_${hosts}_${part}.$ext"
+			[ -s "$TMP/$trace" ] || continue
+			throttle
+			plot "${part}_${partName}_${file}_${label}.png" "$ylabel" "$trace" "($part) $title $variant" &
+			overlay+=("$trace" "$variant")
+
+			# one window per connection in --streams mode
+			if [ "$ext" = cwnd ]; then
+				connections=()
+				for c in "$TMP"/app7_${hosts}_${part}_c*.cwnd; do
+					[ -s "$c" ] || continue
+					c=${c##*/}
+					index=${c##*_c}
+					connections+=("$c" "$variant connection ${index%.cwnd}")
+				done
+				if [ ${#connections[@]} -gt 0 ]; then
+					throttle
+					plot "${part}_${partName}_${file}_connections_cwnd.png" "$ylabel" "${connections[@]}" &
+				fi
+			fi
+		done
+		# all variants of a part on one chart
+		if [ ${#overlay[@]} -gt 2 ]; then
+			throttle
+			plot "${part}_${partName}_variants_${label}.png" "$ylabel" "${overlay[@]}" &
+		fi
+	done
+done
+wait
@@ -67,12 +67,16 @@ Senders	|	H2------R1------R2-----H5	 |	Receivers
 #include <fstream>
 #include <cstdlib>
 #include <map>
+#include <vector>
+#include <sstream>
+#include <algorithm>
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "ns3/traffic-control-module.h"
 #include "ns3/ipv4-global-routing-helper.h"
 
 typedef uint32_t uint;
@@ -89,9 +93,11 @@ class APP: public Application {
 
 		void ScheduleTx(void);
 		void SendPacket(void);
+		Ptr<Socket> NextSocket(void);
 
-		Ptr<Socket>     mSocket;
-		Address         mPeer;
+		std::vector<Ptr<Socket> >	mSockets;
+		std::vector<Address>		mPeers;
+		uint32_t        mNextSocket;
 		uint32_t        mPacketSize;
 		uint32_t        mNPackets;
 		DataRate        mDataRate;
@@ -103,14 +109,15 @@ class APP: public Application {
 		APP();
 		virtual ~APP();
 
-		void Setup(Ptr<Socket> socket, Address address, uint packetSize, uint nPackets, DataRate dataRate);
+		void Setup(std::vector<Ptr<Socket> > sockets, std::vector<Address> addresses, uint packetSize, uint nPackets, DataRate dataRate);
 		void ChangeRate(DataRate newRate);
 		void recv(int numBytesRcvd);
 
 };
 
-APP::APP(): mSocket(0),
-		    mPeer(),
+APP::APP(): mSockets(),
+		    mPeers(),
+		    mNextSocket(0),
 		    mPacketSize(0),
 		    mNPackets(0),
 		    mDataRate(0),
@@ -120,12 +127,16 @@ APP::APP(): mSocket(0),
 }
 
 APP::~APP() {
-	mSocket = 0;
+	mSockets.clear();
 }
 
-void APP::Setup(Ptr<Socket> socket, Address address, uint packetSize, uint nPackets, DataRate dataRate) {
-	mSocket = socket;
-	mPeer = address;
+/*
+	One socket per connection, mSockets[i] connects to addresses[i].
+	The application byte stream is striped over all of them.
+*/
+void APP::Setup(std::vector<Ptr<Socket> > sockets, std::vector<Address> addresses, uint packetSize, uint nPackets, DataRate dataRate) {
+	mSockets = sockets;
+	mPeers = addresses;
 	mPacketSize = packetSize;
 	mNPackets = nPackets;
 	mDataRate = dataRate;
@@ -134,8 +145,11 @@ void APP::Setup(Ptr<Socket> socket, Address address, uint packetSize, uint nPack
 void APP::StartApplication() {
 	mRunning = true;
 	mPacketsSent = 0;
-	mSocket->Bind();
-	mSocket->Connect(mPeer);
+	mNextSocket = 0;
+	for(uint i = 0; i < mSockets.size(); ++i) {
+		mSockets[i]->Bind();
+		mSockets[i]->Connect(mPeers[i]);
+	}
 	SendPacket();
 }
 
@@ -144,14 +158,31 @@ void APP::StopApplication() {
 	if(mSendEvent.IsRunning()) {
 		Simulator::Cancel(mSendEvent);
 	}
-	if(mSocket) {
-		mSocket->Close();
+	for(uint i = 0; i < mSockets.size(); ++i) {
+		mSockets[i]->Close();
+	}
+}
+
+//Round robin over the connections, skipping those whose send buffer
+//cannot take a whole packet so that a stalled connection does not hold
+//back the others
+Ptr<Socket> APP::NextSocket() {
+	uint n = mSockets.size();
+	for(uint i = 0; i < n; ++i) {
+		uint index = (mNextSocket + i) % n;
+		if(mSockets[index]->GetTxAvailable() >= mPacketSize) {
+			mNextSocket = (index + 1) % n;
+			return mSockets[index];
+		}
 	}
+	Ptr<Socket> socket = mSockets[mNextSocket];
+	mNextSocket = (mNextSocket + 1) % n;
+	return socket;
 }
 
 void APP::SendPacket() {
 	Ptr<Packet> packet = Create<Packet>(mPacketSize);
-	mSocket->Send(packet);
+	NextSocket()->Send(packet);
 
 	if(++mPacketsSent < mNPackets) {
 		ScheduleTx();
@@ -177,6 +208,17 @@ static void CwndChange(Ptr<OutputStreamWrapper> stream, double startTime, uint o
 	*stream->GetStream() << Simulator::Now ().GetSeconds () - startTime << "\t" << newCwnd << std::endl;
 }
 
+//Sum of the congestion windows of all connections of a host pair
+std::map<uint, std::map<uint, uint> > mapCwnd;
+static void AggregateCwndChange(Ptr<OutputStreamWrapper> stream, double startTime, std::pair<uint, uint> connection, uint oldCwnd, uint newCwnd) {
+	std::map<uint, uint> &cwnds = mapCwnd[connection.first];
+	cwnds[connection.second] = newCwnd;
+	uint sum = 0;
+	for(std::map<uint, uint>::const_iterator i = cwnds.begin(); i != cwnds.end(); ++i)
+		sum += i->second;
+	*stream->GetStream() << Simulator::Now ().GetSeconds () - startTime << "\t" << sum << std::endl;
+}
+
 std::map<uint, uint> mapDrop;
 static void packetDrop(Ptr<OutputStreamWrapper> stream, double startTime, uint myId) {
 	*stream->GetStream() << Simulator::Now ().GetSeconds () - startTime << "\t" << std::endl;
@@ -193,17 +235,24 @@ void IncRate(Ptr<APP> app, DataRate rate) {
 }
 
 std::map<Address, double> mapBytesReceived;
+std::map<uint, double> mapBytesReceivedApp;
 std::map<std::string, double> mapBytesReceivedIPV4, mapMaxThroughput;
 static double lastTimePrint = 0, lastTimePrintIPV4 = 0;
 double printGap = 0;
+uint numStreams = 1;
 
-void ReceivedPacket(Ptr<OutputStreamWrapper> stream, double startTime, std::string context, Ptr<const Packet> p, const Address& addr){
+//mapBytesReceived counts per connection (keyed by the sender's address and port),
+//the printed goodput is that of all connections of host pair myId
+void ReceivedPacket(Ptr<OutputStreamWrapper> stream, double startTime, uint myId, std::string context, Ptr<const Packet> p, const Address& addr){
 	double timeNow = Simulator::Now().GetSeconds();
 
 	if(mapBytesReceived.find(addr) == mapBytesReceived.end())
 		mapBytesReceived[addr] = 0;
 	mapBytesReceived[addr] += p->GetSize();
-	double kbps_ = (((mapBytesReceived[addr] * 8.0) / 1024)/(timeNow-startTime));
+	if(mapBytesReceivedApp.find(myId) == mapBytesReceivedApp.end())
+		mapBytesReceivedApp[myId] = 0;
+	mapBytesReceivedApp[myId] += p->GetSize();
+	double kbps_ = (((mapBytesReceivedApp[myId] * 8.0) / 1024)/(timeNow-startTime));
 	if(timeNow - lastTimePrint >= printGap) {
 		lastTimePrint = timeNow;
 		*stream->GetStream() << timeNow-startTime << "\t" <<  kbps_ << std::endl;
@@ -228,12 +277,114 @@ void ReceivedPacketIPV4(Ptr<OutputStreamWrapper> stream, double startTime, std::
 }
 
 
-Ptr<Socket> uniFlow(Address sinkAddress, 
-					uint sinkPort, 
-					std::string tcpVariant, 
-					Ptr<Node> hostNode, 
-					Ptr<Node> sinkNode, 
-					double startTime, 
+/*
+	Bottleneck queue (R1 -> R2) events per sending host.
+	A loss burst is a run of drops of one host with none of its packets
+	enqueued in between.
+*/
+std::map<Ipv4Address, uint> mapR1Drop, mapR1Burst, mapR1Mark;
+std::map<Ipv4Address, bool> mapR1InBurst;
+
+Ipv4Address queueItemSource(Ptr<const QueueDiscItem> item) {
+	Ptr<const Ipv4QueueDiscItem> ipv4Item = DynamicCast<const Ipv4QueueDiscItem>(item);
+	return ipv4Item ? ipv4Item->GetHeader().GetSource() : Ipv4Address();
+}
+
+void R1Enqueue(Ptr<const QueueDiscItem> item) {
+	mapR1InBurst[queueItemSource(item)] = false;
+}
+
+void R1Drop(Ptr<const QueueDiscItem> item) {
+	Ipv4Address source = queueItemSource(item);
+	mapR1Drop[source]++;
+	if(!mapR1InBurst[source]) {
+		mapR1InBurst[source] = true;
+		mapR1Burst[source]++;
+	}
+}
+
+void R1Mark(Ptr<const QueueDiscItem> item, const char *reason) {
+	mapR1Mark[queueItemSource(item)]++;
+}
+
+/*
+	Installs the default queue disc on R1's bottleneck device, before any
+	address is assigned so that it can be traced. With ecnBottleneck the same
+	disc, with the same limits, marks ECN-capable packets instead of dropping
+	them, so that only ECN differs between the two.
+*/
+void bottleneckQueue(Ptr<NetDevice> device, bool ecnBottleneck) {
+	TrafficControlHelper tch = TrafficControlHelper::Default();
+	QueueDiscContainer qdiscs = tch.Install(device);
+	if(ecnBottleneck)
+		qdiscs.Get(0)->SetAttribute("UseEcn", BooleanValue(true));
+	qdiscs.Get(0)->TraceConnectWithoutContext("Enqueue", MakeCallback(&R1Enqueue));
+	qdiscs.Get(0)->TraceConnectWithoutContext("Drop", MakeCallback(&R1Drop));
+	qdiscs.Get(0)->TraceConnectWithoutContext("Mark", MakeCallback(&R1Mark));
+}
+
+/*
+	Socket level knobs of a flow, applied to all of its connections.
+	ecn and delayed ACK settings are set on both ends, pacing on the sender.
+	An empty value leaves the ns-3 default (and any --ns3::... override) alone.
+*/
+struct TcpOptions {
+	std::string ecn;
+	std::string pacing;
+	std::string delAckCount;
+	std::string delAckTimeout;
+};
+
+//Comma separated, one value per sender, the last one is repeated for the remaining
+//senders and an empty entry keeps the default for that sender
+std::string ecnFlows, pacingFlows, delAckCountFlows, delAckTimeoutFlows;
+bool ecnBottleneck = false;
+
+std::string flowValue(std::string list, uint flow) {
+	std::istringstream values(list);
+	std::string value;
+	for(uint i = 0; i <= flow && std::getline(values, value, ','); ++i);
+	return value;
+}
+
+TcpOptions flowOptions(uint flow) {
+	TcpOptions options;
+	options.ecn = flowValue(ecnFlows, flow);
+	options.pacing = flowValue(pacingFlows, flow);
+	options.delAckCount = flowValue(delAckCountFlows, flow);
+	options.delAckTimeout = flowValue(delAckTimeoutFlows, flow);
+	return options;
+}
+
+void configureTcpSocket(Ptr<Socket> socket, TcpOptions options, bool sender) {
+	if(!options.ecn.empty())
+		socket->SetAttribute("UseEcn", EnumValue(atoi(options.ecn.c_str()) ? TcpSocketState::On : TcpSocketState::Off));
+	if(!options.delAckCount.empty())
+		socket->SetAttribute("DelAckCount", UintegerValue(atoi(options.delAckCount.c_str())));
+	if(!options.delAckTimeout.empty())
+		socket->SetAttribute("DelAckTimeout", TimeValue(Time(options.delAckTimeout)));
+	if(sender && !options.pacing.empty())
+		DynamicCast<TcpSocketBase>(socket)->SetPacingStatus(atoi(options.pacing.c_str()) != 0);
+}
+
+//Accepted sockets are forked from the listening one and inherit its settings
+void configureSink(Ptr<PacketSink> sink, TcpOptions options) {
+	configureTcpSocket(sink->GetListeningSocket(), options, false);
+}
+
+/*
+	Opens numStreams parallel connections from hostNode to sinkNode,
+	connection i going to a PacketSink on port sinkPort+i.
+	A single APP stripes its packets over all of them.
+*/
+std::vector<Ptr<Socket> > parallelFlow(Ipv4Address sinkAddress,
+					uint sinkPort,
+					uint numStreams,
+					std::string tcpVariant,
+					TcpOptions options,
+					Ptr<Node> hostNode,
+					Ptr<Node> sinkNode,
+					double startTime,
 					double stopTime,
 					uint packetSize,
 					uint numPackets,
@@ -251,21 +402,191 @@ Ptr<Socket> uniFlow(Address sinkAddress,
 		fprintf(stderr, "Invalid TCP version\n");
 		exit(EXIT_FAILURE);
 	}
-	PacketSinkHelper packetSinkHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), sinkPort));
-	ApplicationContainer sinkApps = packetSinkHelper.Install(sinkNode);
-	sinkApps.Start(Seconds(startTime));
-	sinkApps.Stop(Seconds(stopTime));
 
-	Ptr<Socket> ns3TcpSocket = Socket::CreateSocket(hostNode, TcpSocketFactory::GetTypeId());
-	
+	std::vector<Ptr<Socket> > ns3TcpSockets;
+	std::vector<Address> sinkAddresses;
+	for(uint i = 0; i < numStreams; ++i) {
+		PacketSinkHelper packetSinkHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), sinkPort+i));
+		ApplicationContainer sinkApps = packetSinkHelper.Install(sinkNode);
+		sinkApps.Start(Seconds(startTime));
+		sinkApps.Stop(Seconds(stopTime));
+		//PacketSinkHelper takes no socket attributes and the sink creates its
+		//listening socket in StartApplication, with whatever Config defaults
+		//hold at that time, so it is configured right after the sink starts.
+		//Not at startTime: this event is inserted before the sink's start
+		//event, would run first and find no listening socket yet.
+		if(!options.ecn.empty() || !options.delAckCount.empty() || !options.delAckTimeout.empty())
+			Simulator::Schedule(Seconds(startTime) + NanoSeconds(1), &configureSink, DynamicCast<PacketSink>(sinkApps.Get(0)), options);
+
+		Ptr<Socket> ns3TcpSocket = Socket::CreateSocket(hostNode, TcpSocketFactory::GetTypeId());
+		configureTcpSocket(ns3TcpSocket, options, true);
+
+		ns3TcpSockets.push_back(ns3TcpSocket);
+		sinkAddresses.push_back(InetSocketAddress(sinkAddress, sinkPort+i));
+	}
 
 	Ptr<APP> app = CreateObject<APP>();
-	app->Setup(ns3TcpSocket, sinkAddress, packetSize, numPackets, DataRate(dataRate));
+	app->Setup(ns3TcpSockets, sinkAddresses, packetSize, numPackets, DataRate(dataRate));
 	hostNode->AddApplication(app);
 	app->SetStartTime(Seconds(appStartTime));
 	app->SetStopTime(Seconds(appStopTime));
 
-	return ns3TcpSocket;
+	return ns3TcpSockets;
+}
+
+Ptr<Socket> uniFlow(Address sinkAddress, 
+					uint sinkPort, 
+					std::string tcpVariant, 
+					Ptr<Node> hostNode, 
+					Ptr<Node> sinkNode, 
+					double startTime, 
+					double stopTime,
+					uint packetSize,
+					uint numPackets,
+					std::string dataRate,
+					double appStartTime,
+					double appStopTime) {
+	return parallelFlow(InetSocketAddress::ConvertFrom(sinkAddress).GetIpv4(), sinkPort, 1, tcpVariant, TcpOptions(), hostNode, sinkNode, startTime, stopTime, packetSize, numPackets, dataRate, appStartTime, appStopTime)[0];
+}
+
+/*
+	Connects the cwnd and drop traces of every connection of host pair myId.
+	traceName.cwnd gets the summed window, with more than one connection
+	each one additionally gets its own traceName_c<i>.cwnd.
+*/
+void traceFlow(std::vector<Ptr<Socket> > sockets, std::string traceName, double startTime, uint myId, Ptr<OutputStreamWrapper> streamCWND, Ptr<OutputStreamWrapper> streamPD) {
+	AsciiTraceHelper asciiTraceHelper;
+	for(uint i = 0; i < sockets.size(); ++i) {
+		sockets[i]->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&AggregateCwndChange, streamCWND, startTime, std::make_pair(myId, i)));
+		sockets[i]->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, streamPD, startTime, myId));
+		if(sockets.size() > 1) {
+			std::ostringstream fileName;
+			fileName << traceName << "_c" << i << ".cwnd";
+			Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream(fileName.str());
+			sockets[i]->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream, startTime));
+		}
+	}
+}
+
+double kbps(double bytes, double duration) {
+	return duration > 0 ? ((bytes * 8.0) / 1024)/duration : 0;
+}
+
+double meanDelayMs(double delaySum, uint packets) {
+	return packets > 0 ? delaySum*1000/packets : 0;
+}
+
+/*
+	Loss, throughput, goodput, bottleneck drops/marks and delay of host pair
+	myId, summed over all of its connections, followed by throughput, goodput,
+	loss and delay of each connection when there is more than one.
+	Queueing delay is the mean one-way delay less the propagation delay and
+	the serialization of a mean sized packet (plus PPP header) on every hop.
+*/
+void flowSummary(std::map<FlowId, FlowMonitor::FlowStats> stats, Ptr<Ipv4FlowClassifier> classifier, Ipv4Address source, std::string name, uint myId, std::string ipv4Context, double propagationDelay, std::vector<DataRate> hopRates, Ptr<OutputStreamWrapper> stream) {
+	uint numConnections = 0;
+	FlowId firstFlow = 0;
+	Ipv4Address destination;
+	uint lostPackets = 0;
+	double rxBytes = 0, goodputBytes = 0;
+	double firstTx = 0, lastRx = 0;
+	double delaySum = 0;
+	uint rxPackets = 0;
+	std::ostringstream perConnection;
+
+	for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin(); i != stats.end(); ++i) {
+		Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
+		if(t.sourceAddress != source)
+			continue;
+		double txStart = i->second.timeFirstTxPacket.GetSeconds();
+		double rxEnd = i->second.timeLastRxPacket.GetSeconds();
+		double goodBytes = mapBytesReceived[InetSocketAddress(t.sourceAddress, t.sourcePort)];
+		if(numConnections == 0) {
+			firstFlow = i->first;
+			destination = t.destinationAddress;
+			firstTx = txStart;
+		}
+		numConnections++;
+		lostPackets += i->second.lostPackets;
+		rxBytes += i->second.rxBytes;
+		goodputBytes += goodBytes;
+		delaySum += i->second.delaySum.GetSeconds();
+		rxPackets += i->second.rxPackets;
+		firstTx = std::min(firstTx, txStart);
+		lastRx = std::max(lastRx, rxEnd);
+
+		perConnection << "Connection " << i->first << " (" << t.sourceAddress << ":" << t.sourcePort << " -> " << t.destinationAddress << ":" << t.destinationPort << ")\n";
+		perConnection << "  Packet Lost: " << i->second.lostPackets << "\n";
+		perConnection << "  Throughput: " << kbps(i->second.rxBytes, rxEnd - txStart) << "\n";
+		perConnection << "  Goodput: " << kbps(goodBytes, rxEnd - txStart) << "\n";
+		perConnection << "  Mean delay(ms): " << meanDelayMs(i->second.delaySum.GetSeconds(), i->second.rxPackets) << "\n";
+	}
+	if(numConnections == 0)
+		return;
+
+	if(mapDrop.find(myId)==mapDrop.end())
+		mapDrop[myId] = 0;
+	*stream->GetStream() << name << " Flow " << firstFlow  << " (" << source << " -> " << destination << ")\n";
+	*stream->GetStream()  << "Net Packet Lost: " << lostPackets << "\n";
+	*stream->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[myId] << "\n";
+	*stream->GetStream()  << "Packet Lost due to Congestion: " << lostPackets - mapDrop[myId] << "\n";
+	*stream->GetStream() << "Max throughput: " << mapMaxThroughput[ipv4Context] << std::endl;
+	*stream->GetStream() << "Throughput: " << kbps(rxBytes, lastRx - firstTx) << "\n";
+	*stream->GetStream() << "Goodput: " << kbps(goodputBytes, lastRx - firstTx) << "\n";
+	*stream->GetStream() << "Drops at R1: " << mapR1Drop[source] << " in " << mapR1Burst[source] << " bursts\n";
+	*stream->GetStream() << "ECN marks at R1: " << mapR1Mark[source] << "\n";
+	*stream->GetStream() << "Mean delay(ms): " << meanDelayMs(delaySum, rxPackets) << "\n";
+	double baseDelay = propagationDelay;
+	if(rxPackets > 0) {
+		PppHeader ppp;
+		for(uint i = 0; i < hopRates.size(); ++i)
+			baseDelay += hopRates[i].CalculateBytesTxTime(static_cast<uint>(rxBytes/rxPackets) + ppp.GetSerializedSize()).GetSeconds();
+	}
+	*stream->GetStream() << "Mean queueing delay(ms): " << (rxPackets > 0 ? meanDelayMs(delaySum, rxPackets) - baseDelay*1000 : 0) << std::endl;
+	if(numConnections > 1) {
+		*stream->GetStream() << "Parallel connections: " << numConnections << "\n";
+		*stream->GetStream() << perConnection.str() << std::flush;
+	}
+}
+
+/*
+	Event scheduler used by the SimulatorImplementation.
+	The SchedulerType global value is read whenever the simulator is
+	(re)created, i.e. on first use and after every Simulator::Destroy().
+*/
+std::string schedulerTypeId(std::string scheduler) {
+	if(scheduler.compare("Map") == 0) {
+		return "ns3::MapScheduler";
+	} else if(scheduler.compare("Heap") == 0) {
+		return "ns3::HeapScheduler";
+	} else if(scheduler.compare("List") == 0) {
+		return "ns3::ListScheduler";
+	} else if(scheduler.compare("Calendar") == 0) {
+		return "ns3::CalendarScheduler";
+	} else if(scheduler.compare("PriorityQueue") == 0) {
+		return "ns3::PriorityQueueScheduler";
+	}
+	fprintf(stderr, "Invalid scheduler\n");
+	exit(EXIT_FAILURE);
+}
+
+void setScheduler(std::string scheduler) {
+	GlobalValue::Bind("SchedulerType", StringValue(schedulerTypeId(scheduler)));
+}
+
+//Reads a field (in kB) such as "VmRSS:" or "VmHWM:" from /proc/self/status
+double memoryKB(std::string field) {
+	std::ifstream status("/proc/self/status");
+	std::string key;
+	double value = 0;
+	while(status >> key) {
+		if(key.compare(field) == 0) {
+			status >> value;
+			break;
+		}
+		status.ignore(256, '\n');
+	}
+	return value;
 }
 
 void partAC() {
@@ -374,6 +695,7 @@ void partAC() {
 
 	//Assign IP addresses to the net devices specified in the container 
 	//based on the current network prefix and address base
+	bottleneckQueue(routerDevices.Get(0), ecnBottleneck);
 	routerIFC = routerIP.Assign(routerDevices);
 
 	for(uint i = 0; i < numSender; ++i) {
@@ -421,13 +743,12 @@ void partAC() {
 	Ptr<OutputStreamWrapper> stream1PD = asciiTraceHelper.CreateFileStream("app7_h1_h4_a.congestion_loss");
 	Ptr<OutputStreamWrapper> stream1TP = asciiTraceHelper.CreateFileStream("app7_h1_h4_a.tp");
 	Ptr<OutputStreamWrapper> stream1GP = asciiTraceHelper.CreateFileStream("app7_h1_h4_a.gp");
-	Ptr<Socket> ns3TcpSocket1 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(0), port), port, "TcpReno", senders.Get(0), receivers.Get(0), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
-	ns3TcpSocket1->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream1CWND, netDuration));
-	ns3TcpSocket1->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream1PD, netDuration, 1));
+	std::vector<Ptr<Socket> > ns3TcpSockets1 = parallelFlow(receiverIFCs.GetAddress(0), port, numStreams, "TcpReno", flowOptions(0), senders.Get(0), receivers.Get(0), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
+	traceFlow(ns3TcpSockets1, "app7_h1_h4_a", netDuration, 1, stream1CWND, stream1PD);
 
 	// Measure PacketSinks
-	std::string sink = "/NodeList/5/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream1GP, netDuration));
+	std::string sink = "/NodeList/5/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream1GP, netDuration, 1));
 
 	std::string sink_ = "/NodeList/5/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream1TP, netDuration));
@@ -440,12 +761,11 @@ void partAC() {
 	Ptr<OutputStreamWrapper> stream2PD = asciiTraceHelper.CreateFileStream("app7_h2_h5_a.congestion_loss");
 	Ptr<OutputStreamWrapper> stream2TP = asciiTraceHelper.CreateFileStream("app7_h2_h5_a.tp");
 	Ptr<OutputStreamWrapper> stream2GP = asciiTraceHelper.CreateFileStream("app7_h2_h5_a.gp");
-	Ptr<Socket> ns3TcpSocket2 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(1), port), port, "TcpNewReno", senders.Get(1), receivers.Get(1), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
-	ns3TcpSocket2->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream2CWND, netDuration));
-	ns3TcpSocket2->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream2PD, netDuration, 2));
+	std::vector<Ptr<Socket> > ns3TcpSockets2 = parallelFlow(receiverIFCs.GetAddress(1), port, numStreams, "TcpNewReno", flowOptions(1), senders.Get(1), receivers.Get(1), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
+	traceFlow(ns3TcpSockets2, "app7_h2_h5_a", netDuration, 2, stream2CWND, stream2PD);
 
-	sink = "/NodeList/6/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream2GP, netDuration));
+	sink = "/NodeList/6/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream2GP, netDuration, 2));
 	sink_ = "/NodeList/6/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream2TP, netDuration));
 	netDuration += durationGap;
@@ -455,12 +775,11 @@ void partAC() {
 	Ptr<OutputStreamWrapper> stream3PD = asciiTraceHelper.CreateFileStream("app7_h3_h6_a.congestion_loss");
 	Ptr<OutputStreamWrapper> stream3TP = asciiTraceHelper.CreateFileStream("app7_h3_h6_a.tp");
 	Ptr<OutputStreamWrapper> stream3GP = asciiTraceHelper.CreateFileStream("app7_h3_h6_a.gp");
-	Ptr<Socket> ns3TcpSocket3 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(2), port), port, "TcpBic", senders.Get(2), receivers.Get(2), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
-	ns3TcpSocket3->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream3CWND, netDuration));
-	ns3TcpSocket3->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream3PD, netDuration, 3));
+	std::vector<Ptr<Socket> > ns3TcpSockets3 = parallelFlow(receiverIFCs.GetAddress(2), port, numStreams, "TcpBic", flowOptions(2), senders.Get(2), receivers.Get(2), netDuration, netDuration+durationGap, packetSize, numPackets, transferSpeed, netDuration, netDuration+durationGap);
+	traceFlow(ns3TcpSockets3, "app7_h3_h6_a", netDuration, 3, stream3CWND, stream3PD);
 
-	sink = "/NodeList/7/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream3GP, netDuration));
+	sink = "/NodeList/7/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream3GP, netDuration, 3));
 	sink_ = "/NodeList/7/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream3TP, netDuration));
 	netDuration += durationGap;
@@ -480,42 +799,15 @@ void partAC() {
 
 	//Ptr<OutputStreamWrapper> streamTP = asciiTraceHelper.CreateFileStream("app7_a.tp");
 	Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+	double propagationDelay = 2*Time(latencyHR).GetSeconds() + Time(latencyRR).GetSeconds();
+	std::vector<DataRate> hopRates;
+	hopRates.push_back(DataRate(rateHR));
+	hopRates.push_back(DataRate(rateRR));
+	hopRates.push_back(DataRate(rateHR));
 	std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-	for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin(); i != stats.end(); ++i) {
-		Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
-		/*
-		*streamTP->GetStream()  << "Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-		*streamTP->GetStream()  << "  Tx Bytes:   " << i->second.txBytes << "\n";
-		*streamTP->GetStream()  << "  Rx Bytes:   " << i->second.rxBytes << "\n";
-		*streamTP->GetStream()  << "  Time        " << i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds() << "\n";
-		*streamTP->GetStream()  << "  Throughput: " << i->second.rxBytes * 8.0 / (i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds())/1024/1024  << " Mbps\n";	
-		*/
-		if(t.sourceAddress == "10.1.0.1") {
-			if(mapDrop.find(1)==mapDrop.end())
-				mapDrop[1] = 0;
-			*stream1PD->GetStream() << "TcpReno Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream1PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream1PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[1] << "\n";
-			*stream1PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[1] << "\n";
-			*stream1PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/5/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		} else if(t.sourceAddress == "10.1.1.1") {
-			if(mapDrop.find(2)==mapDrop.end())
-				mapDrop[2] = 0;
-			*stream2PD->GetStream() << "Tcp NewReno Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream2PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream2PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[2] << "\n";
-			*stream2PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[2] << "\n";
-			*stream2PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/6/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		} else if(t.sourceAddress == "10.1.2.1") {
-			if(mapDrop.find(3)==mapDrop.end())
-				mapDrop[3] = 0;
-			*stream3PD->GetStream() << "Tcp Bic Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream3PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream3PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[3] << "\n";
-			*stream3PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[3] << "\n";
-			*stream3PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/7/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		}
-	}
+	flowSummary(stats, classifier, "10.1.0.1", "TcpReno", 1, "/NodeList/5/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream1PD);
+	flowSummary(stats, classifier, "10.1.1.1", "Tcp NewReno", 2, "/NodeList/6/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream2PD);
+	flowSummary(stats, classifier, "10.1.2.1", "Tcp Bic", 3, "/NodeList/7/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream3PD);
 
 	//flowmon->SerializeToXmlFile("app7_a.flowmon", true, true);
 	Simulator::Destroy();
@@ -591,6 +883,7 @@ void partBC() {
 
 	Ipv4InterfaceContainer routerIFC, senderIFCs, receiverIFCs, leftRouterIFCs, rightRouterIFCs;
 
+	bottleneckQueue(routerDevices.Get(0), ecnBottleneck);
 	routerIFC = routerIP.Assign(routerDevices);
 
 	for(uint i = 0; i < numSender; ++i) {
@@ -632,13 +925,12 @@ void partBC() {
 	Ptr<OutputStreamWrapper> stream1PD = asciiTraceHelper.CreateFileStream("app7_h1_h4_b.congestion_loss");
 	Ptr<OutputStreamWrapper> stream1TP = asciiTraceHelper.CreateFileStream("app7_h1_h4_b.tp");
 	Ptr<OutputStreamWrapper> stream1GP = asciiTraceHelper.CreateFileStream("app7_h1_h4_b.gp");
-	Ptr<Socket> ns3TcpSocket1 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(0), port), port, "TcpReno", senders.Get(0), receivers.Get(0), oneFlowStart, oneFlowStart+durationGap, packetSize, numPackets, transferSpeed, oneFlowStart, oneFlowStart+durationGap);
-	ns3TcpSocket1->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream1CWND, 0));
-	ns3TcpSocket1->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream1PD, 0, 1));
+	std::vector<Ptr<Socket> > ns3TcpSockets1 = parallelFlow(receiverIFCs.GetAddress(0), port, numStreams, "TcpReno", flowOptions(0), senders.Get(0), receivers.Get(0), oneFlowStart, oneFlowStart+durationGap, packetSize, numPackets, transferSpeed, oneFlowStart, oneFlowStart+durationGap);
+	traceFlow(ns3TcpSockets1, "app7_h1_h4_b", 0, 1, stream1CWND, stream1PD);
 
 
-	std::string sink = "/NodeList/5/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream1GP, 0));
+	std::string sink = "/NodeList/5/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream1GP, 0, 1));
 	std::string sink_ = "/NodeList/5/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream1TP, 0));
 
@@ -647,12 +939,11 @@ void partBC() {
 	Ptr<OutputStreamWrapper> stream2PD = asciiTraceHelper.CreateFileStream("app7_h2_h5_b.congestion_loss");
 	Ptr<OutputStreamWrapper> stream2TP = asciiTraceHelper.CreateFileStream("app7_h2_h5_b.tp");
 	Ptr<OutputStreamWrapper> stream2GP = asciiTraceHelper.CreateFileStream("app7_h2_h5_b.gp");
-	Ptr<Socket> ns3TcpSocket2 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(1), port), port, "TcpNewReno", senders.Get(1), receivers.Get(1), otherFlowStart, otherFlowStart+durationGap, packetSize, numPackets, transferSpeed, otherFlowStart, otherFlowStart+durationGap);
-	ns3TcpSocket2->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream2CWND, 0));
-	ns3TcpSocket2->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream2PD, 0, 2));
+	std::vector<Ptr<Socket> > ns3TcpSockets2 = parallelFlow(receiverIFCs.GetAddress(1), port, numStreams, "TcpNewReno", flowOptions(1), senders.Get(1), receivers.Get(1), otherFlowStart, otherFlowStart+durationGap, packetSize, numPackets, transferSpeed, otherFlowStart, otherFlowStart+durationGap);
+	traceFlow(ns3TcpSockets2, "app7_h2_h5_b", 0, 2, stream2CWND, stream2PD);
 
-	sink = "/NodeList/6/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream2GP, 0));
+	sink = "/NodeList/6/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream2GP, 0, 2));
 	sink_ = "/NodeList/6/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream2TP, 0));
 
@@ -661,12 +952,11 @@ void partBC() {
 	Ptr<OutputStreamWrapper> stream3PD = asciiTraceHelper.CreateFileStream("app7_h3_h6_b.congestion_loss");
 	Ptr<OutputStreamWrapper> stream3TP = asciiTraceHelper.CreateFileStream("app7_h3_h6_b.tp");
 	Ptr<OutputStreamWrapper> stream3GP = asciiTraceHelper.CreateFileStream("app7_h3_h6_b.gp");
-	Ptr<Socket> ns3TcpSocket3 = uniFlow(InetSocketAddress(receiverIFCs.GetAddress(2), port), port, "TcpBic", senders.Get(2), receivers.Get(2), otherFlowStart, otherFlowStart+durationGap, packetSize, numPackets, transferSpeed, otherFlowStart, otherFlowStart+durationGap);
-	ns3TcpSocket3->TraceConnectWithoutContext("CongestionWindow", MakeBoundCallback (&CwndChange, stream3CWND, 0));
-	ns3TcpSocket3->TraceConnectWithoutContext("Drop", MakeBoundCallback (&packetDrop, stream3PD, 0, 3));
+	std::vector<Ptr<Socket> > ns3TcpSockets3 = parallelFlow(receiverIFCs.GetAddress(2), port, numStreams, "TcpBic", flowOptions(2), senders.Get(2), receivers.Get(2), otherFlowStart, otherFlowStart+durationGap, packetSize, numPackets, transferSpeed, otherFlowStart, otherFlowStart+durationGap);
+	traceFlow(ns3TcpSockets3, "app7_h3_h6_b", 0, 3, stream3CWND, stream3PD);
 
-	sink = "/NodeList/7/ApplicationList/0/$ns3::PacketSink/Rx";
-	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream3GP, 0));
+	sink = "/NodeList/7/ApplicationList/*/$ns3::PacketSink/Rx";
+	Config::Connect(sink, MakeBoundCallback(&ReceivedPacket, stream3GP, 0, 3));
 	sink_ = "/NodeList/7/$ns3::Ipv4L3Protocol/Rx";
 	Config::Connect(sink_, MakeBoundCallback(&ReceivedPacketIPV4, stream3TP, 0));
 
@@ -685,54 +975,181 @@ void partBC() {
 
 	//Ptr<OutputStreamWrapper> streamTP = asciiTraceHelper.CreateFileStream("app7_b.tp");
 	Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+	double propagationDelay = 2*Time(latencyHR).GetSeconds() + Time(latencyRR).GetSeconds();
+	std::vector<DataRate> hopRates;
+	hopRates.push_back(DataRate(rateHR));
+	hopRates.push_back(DataRate(rateRR));
+	hopRates.push_back(DataRate(rateHR));
 	std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-	for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin(); i != stats.end(); ++i) {
-		Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
-		/*
-		*streamTP->GetStream()  << "Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-		*streamTP->GetStream()  << "  Tx Bytes:   " << i->second.txBytes << "\n";
-		*streamTP->GetStream()  << "  Rx Bytes:   " << i->second.rxBytes << "\n";
-		*streamTP->GetStream()  << "  Time        " << i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds() << "\n";
-		*streamTP->GetStream()  << "  Throughput: " << i->second.rxBytes * 8.0 / (i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds())/1024/1024  << " Mbps\n";	
-		*/
-		if(t.sourceAddress == "10.1.0.1") {
-			if(mapDrop.find(1)==mapDrop.end())
-				mapDrop[1] = 0;
-			*stream1PD->GetStream() << "TcpReno Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream1PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream1PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[1] << "\n";
-			*stream1PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[1] << "\n";
-			*stream1PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/5/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		} else if(t.sourceAddress == "10.1.1.1") {
-			if(mapDrop.find(2)==mapDrop.end())
-				mapDrop[2] = 0;
-			*stream2PD->GetStream() << "TcpNewReno Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream2PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream2PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[2] << "\n";
-			*stream2PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[2] << "\n";
-			*stream2PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/6/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		} else if(t.sourceAddress == "10.1.2.1") {
-			if(mapDrop.find(3)==mapDrop.end())
-				mapDrop[3] = 0;
-			*stream3PD->GetStream() << "TcpBic Flow " << i->first  << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
-			*stream3PD->GetStream()  << "Net Packet Lost: " << i->second.lostPackets << "\n";
-			*stream3PD->GetStream()  << "Packet Lost due to buffer overflow: " << mapDrop[3] << "\n";
-			*stream3PD->GetStream()  << "Packet Lost due to Congestion: " << i->second.lostPackets - mapDrop[3] << "\n";
-			*stream3PD->GetStream() << "Max throughput: " << mapMaxThroughput["/NodeList/7/$ns3::Ipv4L3Protocol/Rx"] << std::endl;
-		}
-	}
+	flowSummary(stats, classifier, "10.1.0.1", "TcpReno", 1, "/NodeList/5/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream1PD);
+	flowSummary(stats, classifier, "10.1.1.1", "TcpNewReno", 2, "/NodeList/6/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream2PD);
+	flowSummary(stats, classifier, "10.1.2.1", "TcpBic", 3, "/NodeList/7/$ns3::Ipv4L3Protocol/Rx", propagationDelay, hopRates, stream3PD);
 
 	//flowmon->SerializeToXmlFile("app7_b.flowmon", true, true);
 	Simulator::Destroy();
 
 }
 
+/********************************************************************
+SCHEDULER BENCHMARK
+********************************************************************/
+/********************************************************************
+	Same dumbbell as part (b) but with numFlows host pairs, all flows
+	started together and the tcp variants assigned round robin.
+	No trace files are written so that the run time is dominated by
+	the event queue and the network stack, then
+	1) events executed per wall clock second
+	2) resident memory grown while building and running the scenario
+	3) peak resident memory of the process
+	are reported for the scheduler currently bound to SchedulerType.
+	Memory figures only mean something for one run per process: VmHWM
+	never goes down and freed heap stays with the process, so
+	benchmark.sh starts a fresh process for every (scheduler, flows) pair.
+********************************************************************/
+void benchmarkRun(std::string scheduler, uint numFlows, double duration, Ptr<OutputStreamWrapper> stream) {
+	std::string rateHR = "100Mbps";
+	std::string latencyHR = "20ms";
+	std::string rateRR = "10Mbps";
+	std::string latencyRR = "50ms";
+
+	uint packetSize = 1.2*1024;		//1.2KB
+	double errorP = ERROR;
+	uint port = 9000;
+	uint numPackets = 10000000;
+	std::string transferSpeed = "400Mbps";
+	std::string tcpVariants[] = {"TcpReno", "TcpNewReno", "TcpBic"};
+
+	setScheduler(scheduler);
+	double rssStart = memoryKB("VmRSS:");
+
+	PointToPointHelper p2pHR, p2pRR;
+	p2pHR.SetDeviceAttribute("DataRate", StringValue(rateHR));
+	p2pHR.SetChannelAttribute("Delay", StringValue(latencyHR));
+	p2pRR.SetDeviceAttribute("DataRate", StringValue(rateRR));
+	p2pRR.SetChannelAttribute("Delay", StringValue(latencyRR));
+
+	Ptr<RateErrorModel> em = CreateObjectWithAttributes<RateErrorModel> ("ErrorRate", DoubleValue (errorP));
+
+	NodeContainer routers, senders, receivers;
+	routers.Create(2);
+	senders.Create(numFlows);
+	receivers.Create(numFlows);
+
+	NetDeviceContainer routerDevices = p2pRR.Install(routers);
+	NetDeviceContainer leftRouterDevices, rightRouterDevices, senderDevices, receiverDevices;
+
+	for(uint i = 0; i < numFlows; ++i) {
+		NetDeviceContainer cleft = p2pHR.Install(routers.Get(0), senders.Get(i));
+		leftRouterDevices.Add(cleft.Get(0));
+		senderDevices.Add(cleft.Get(1));
+		cleft.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+
+		NetDeviceContainer cright = p2pHR.Install(routers.Get(1), receivers.Get(i));
+		rightRouterDevices.Add(cright.Get(0));
+		receiverDevices.Add(cright.Get(1));
+		cright.Get(0)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+	}
+
+	InternetStackHelper stack;
+	stack.Install(routers);
+	stack.Install(senders);
+	stack.Install(receivers);
+
+	//a /24 per host link would run the 10.1.x.0 senders into the 10.2.x.0 receivers
+	//after 256 flows, so each host link gets a /30 instead
+	Ipv4AddressHelper routerIP = Ipv4AddressHelper("10.3.0.0", "255.255.255.0");
+	Ipv4AddressHelper senderIP = Ipv4AddressHelper("10.1.0.0", "255.255.255.252");
+	Ipv4AddressHelper receiverIP = Ipv4AddressHelper("10.2.0.0", "255.255.255.252");
+
+	Ipv4InterfaceContainer routerIFC, senderIFCs, receiverIFCs;
+	routerIFC = routerIP.Assign(routerDevices);
+
+	for(uint i = 0; i < numFlows; ++i) {
+		NetDeviceContainer senderDevice;
+		senderDevice.Add(senderDevices.Get(i));
+		senderDevice.Add(leftRouterDevices.Get(i));
+		senderIFCs.Add(senderIP.Assign(senderDevice).Get(0));
+		senderIP.NewNetwork();
+
+		NetDeviceContainer receiverDevice;
+		receiverDevice.Add(receiverDevices.Get(i));
+		receiverDevice.Add(rightRouterDevices.Get(i));
+		receiverIFCs.Add(receiverIP.Assign(receiverDevice).Get(0));
+		receiverIP.NewNetwork();
+	}
+
+	for(uint i = 0; i < numFlows; ++i) {
+		uniFlow(InetSocketAddress(receiverIFCs.GetAddress(i), port), port, tcpVariants[i%3], senders.Get(i), receivers.Get(i), 0, duration, packetSize, numPackets, transferSpeed, 0, duration);
+	}
+
+	Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+	SystemWallClockMs wallClock;
+	wallClock.Start();
+	Simulator::Stop(Seconds(duration));
+	Simulator::Run();
+	double wallSeconds = wallClock.End()/1000.0;
+
+	uint64_t numEvents = Simulator::GetEventCount();
+	double eventsPerSecond = wallSeconds > 0 ? numEvents/wallSeconds : 0;
+	double rssGrowth = memoryKB("VmRSS:") - rssStart;
+
+	*stream->GetStream() << scheduler << "\t" << numFlows << "\t" << numEvents << "\t" << wallSeconds << "\t"
+						 << eventsPerSecond << "\t" << rssGrowth << "\t" << memoryKB("VmHWM:") << std::endl;
+	std::cout << scheduler << " scheduler, " << numFlows << " flows: " << numEvents << " events in " << wallSeconds
+			  << "s (" << eventsPerSecond << " events/s), memory +" << rssGrowth << " kB" << std::endl;
+
+	Simulator::Destroy();
+}
+
+//Appends one row to app7_scheduler_benchmark.txt, benchmark.sh writes the header
+void benchmark(std::string scheduler, uint numFlows, double duration) {
+	std::cout << "Scheduler benchmark started..." << std::endl;
+	//fails with "Invalid scheduler" before anything is written
+	schedulerTypeId(scheduler);
+	if(numFlows < 1) {
+		fprintf(stderr, "Invalid number of benchmark flows\n");
+		exit(EXIT_FAILURE);
+	}
+
+	AsciiTraceHelper asciiTraceHelper;
+	Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream("app7_scheduler_benchmark.txt", std::ios::out | std::ios::app);
+	benchmarkRun(scheduler, numFlows, duration, stream);
+}
+
 int main(int argc, char **argv) {
 	CommandLine cmd;
 	std::string type;
+	std::string scheduler;
+	bool runBenchmark = false;
+	uint benchmarkFlows = 3;
+	double benchmarkTime = 5;
   	cmd.AddValue ("part", "Which part to run?", type);
+  	cmd.AddValue ("streams", "Parallel TCP connections per sender/receiver pair", numStreams);
+  	cmd.AddValue ("ecn", "ECN on each flow (0/1, comma separated per sender)", ecnFlows);
+  	cmd.AddValue ("ecnBottleneck", "ECN marking in the default queue disc at R1", ecnBottleneck);
+  	cmd.AddValue ("pacing", "Sender pacing on each flow (0/1, comma separated per sender)", pacingFlows);
+  	cmd.AddValue ("delAckCount", "Receiver delayed ACK count of each flow (comma separated per sender)", delAckCountFlows);
+  	cmd.AddValue ("delAckTimeout", "Receiver delayed ACK timeout of each flow (comma separated per sender)", delAckTimeoutFlows);
+  	cmd.AddValue ("scheduler", "Event scheduler: Map, Heap, List, Calendar or PriorityQueue", scheduler);
+  	cmd.AddValue ("benchmark", "Benchmark the scheduler given with --scheduler (see benchmark.sh)", runBenchmark);
+  	cmd.AddValue ("benchmarkFlows", "Number of flows of the benchmark run", benchmarkFlows);
+  	cmd.AddValue ("benchmarkTime", "Simulated seconds per benchmark run", benchmarkTime);
   	cmd.Parse (argc, argv);
-		
+
+	if(numStreams < 1) {
+		fprintf(stderr, "Invalid number of streams\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if(runBenchmark) {
+		benchmark(scheduler, benchmarkFlows, benchmarkTime);
+		return 0;
+	}
+
+	if(!scheduler.empty())
+		setScheduler(scheduler);
+
 	if(atoi(type.c_str()) == 1)
 		partAC();
 	else